@@ -25,15 +25,17 @@ public:
    * @brief Construct a Button with the specified pin.
    *
    * Configures the pin as input with internal pull-up resistor and
-   * sets a 2ms debounce interval.
+   * sets the debounce interval.
    *
    * @param pin The GPIO pin connected to the button
+   * @param interval The debounce interval in ms
    */
-  Button(uint8_t pin) : _button() {
+  Button(uint8_t pin, uint16_t interval = 2) : _button() {
     _button.attach(pin, INPUT_PULLUP);
     // From testing the left and right click of the ex-g were a little over
-    // 1 ms bouncing. The middle click was closer to 600 micros for bouncing
-    _button.interval(2);
+    // 1 ms bouncing. The middle click was closer to 600 micros for bouncing,
+    // hence the 2 ms default.
+    _button.interval(interval);
     _button.setPressedState(LOW);
   }
 
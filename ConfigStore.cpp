@@ -0,0 +1,182 @@
+#include "ConfigStore.hpp"
+#include <cstring>
+
+const char *const NAMESPACE = "ex-g";
+const char *const CONFIG_KEY = "config";
+
+// Time the config must be unchanged before it's written, in ms. Stepping
+// through settings only costs one flash write once the user has settled.
+const uint32_t SETTLE_TIME = 5'000;
+
+// FNV-1a, https://datatracker.ietf.org/doc/html/draft-eastlake-fnv
+const uint32_t FNV_OFFSET_BASIS = 0x811C9DC5;
+const uint32_t FNV_PRIME = 0x01000193;
+
+struct ConfigHeader {
+  uint16_t version;
+  // Bytes of Config that follow the header
+  uint16_t size;
+  uint32_t checksum;
+};
+
+struct ConfigBlob {
+  ConfigHeader header;
+  Config config;
+};
+
+// Room for fields appended by newer firmware, so their blobs can still be read
+const size_t MAX_STORED_CONFIG_SIZE = 64;
+static_assert(sizeof(Config) <= MAX_STORED_CONFIG_SIZE,
+              "Config no longer fits the stored blob buffer");
+
+struct StoredBlob {
+  ConfigHeader header;
+  uint8_t data[MAX_STORED_CONFIG_SIZE];
+};
+
+/**
+ * @brief Convert stored config data of the given version to the current Config.
+ *
+ * @param version The version of the stored data.
+ * @param data The stored config bytes.
+ * @param size The number of stored config bytes.
+ * @param config The config to fill in, fields not stored keep their value.
+ * @return false if the version is unknown.
+ */
+static bool migrate(uint16_t version, const uint8_t *data, uint16_t size,
+                    Config &config) {
+  switch (version) {
+  case CONFIG_VERSION:
+    // Only appended to, so older blobs are a prefix of the current one and
+    // newer blobs have fields this firmware doesn't know about
+    std::memcpy(&config, data, size < sizeof(Config) ? size : sizeof(Config));
+    return true;
+  default:
+    return false;
+  }
+}
+
+ConfigStore::ConfigStore()
+    : _preferences(), _config(), _stored(), _rewrite(false), _pending(false),
+      _changedAt(0) {}
+
+const Config &ConfigStore::load() {
+  _config = Config{};
+  _stored = _config;
+  _rewrite = false;
+  _pending = false;
+  // Any rewrite waits until SETTLE_TIME after boot
+  _changedAt = 0;
+
+  StoredBlob blob;
+  size_t length = 0;
+  bool tooLarge = false;
+  // Opening read only fails when nothing was ever stored
+  if (_preferences.begin(NAMESPACE, true)) {
+    length = _preferences.getBytes(CONFIG_KEY, &blob, sizeof(blob));
+    // getBytes() also fails for blobs larger than the buffer
+    tooLarge = length == 0 && _preferences.getBytesLength(CONFIG_KEY) != 0;
+    _preferences.end();
+  }
+  if (tooLarge) {
+    // Can only be from newer firmware, only replace it when the config is set()
+    _rewrite = true;
+    return _config;
+  }
+  if (length == 0) {
+    return _config;
+  }
+
+  const auto &header = blob.header;
+  bool valid = length >= sizeof(header) &&
+               length == sizeof(header) + header.size &&
+               header.checksum == checksum(header.version, blob.data,
+                                           header.size);
+  if (valid && header.version > CONFIG_VERSION) {
+    // Written by newer firmware, only replace it when the config is set()
+    _rewrite = true;
+    return _config;
+  }
+  if (!valid || !migrate(header.version, blob.data, header.size, _config)) {
+    // Replace the unusable blob with the defaults once settled
+    _config = Config{};
+    _rewrite = true;
+    _pending = true;
+    return _config;
+  }
+
+  _stored = _config;
+  if (header.size > sizeof(Config)) {
+    // Has fields appended by newer firmware, keep until the config is set()
+    _rewrite = true;
+    return _config;
+  }
+  _rewrite = header.size != sizeof(Config);
+  _pending = _rewrite;
+  return _config;
+}
+
+void ConfigStore::set(const Config &config, uint32_t now) {
+  _config = config;
+  _pending = true;
+  _changedAt = now;
+}
+
+bool ConfigStore::update(uint32_t now) {
+  if (!_pending || now - _changedAt < SETTLE_TIME) {
+    return false;
+  }
+  _pending = false;
+  if (_config == _stored && !_rewrite) {
+    return false;
+  }
+
+  ConfigBlob blob;
+  blob.header.version = CONFIG_VERSION;
+  blob.header.size = sizeof(Config);
+  blob.config = _config;
+  blob.header.checksum = checksum(
+      blob.header.version, (const uint8_t *)&blob.config, blob.header.size);
+
+  // Leave off any padding after the config
+  const size_t length = sizeof(blob.header) + sizeof(blob.config);
+  size_t written = 0;
+  if (_preferences.begin(NAMESPACE, false)) {
+    written = _preferences.putBytes(CONFIG_KEY, &blob, length);
+    _preferences.end();
+  }
+  if (written != length) {
+    // Try again once another SETTLE_TIME has passed
+    _pending = true;
+    _changedAt = now;
+    return false;
+  }
+  _stored = _config;
+  _rewrite = false;
+  return true;
+}
+
+/**
+ * @brief Compute the checksum of a stored config.
+ *
+ * The version is included so a blob can't be misread as another version.
+ *
+ * @param version The config version the data is from.
+ * @param data The config bytes.
+ * @param size The number of config bytes.
+ * @return The FNV-1a hash of the version and data.
+ */
+uint32_t ConfigStore::checksum(uint16_t version, const uint8_t *data,
+                               uint16_t size) {
+  uint32_t hash = FNV_OFFSET_BASIS;
+  auto add = [&hash](uint8_t byte) {
+    hash ^= byte;
+    hash *= FNV_PRIME;
+  };
+  add((uint8_t)(version & 0xFF));
+  add((uint8_t)(version >> 8));
+  for (uint16_t i = 0; i < size; i++) {
+    add(data[i]);
+  }
+  return hash;
+}
@@ -0,0 +1,98 @@
+#ifndef CONFIG_STORE_HPP
+#define CONFIG_STORE_HPP
+#include <Preferences.h>
+#include <cstdint>
+
+/**
+ * @brief Runtime settings persisted across power cycles.
+ *
+ * This is stored in flash as is. Within a version new fields must only be
+ * appended, blobs missing them will load with the defaults below. Any other
+ * layout change must bump CONFIG_VERSION and add a case migrating the previous
+ * layout to migrate() in ConfigStore.cpp.
+ */
+struct Config {
+  // Sensor resolution in 250 DPI steps, see MotionSensor. 6 is 1500 DPI.
+  uint8_t resolution = 6;
+  // Button debounce interval in ms, see Button
+  uint8_t debounceInterval = 2;
+
+  bool operator==(const Config &other) const {
+    return resolution == other.resolution &&
+           debounceInterval == other.debounceInterval;
+  }
+  bool operator!=(const Config &other) const { return !(*this == other); }
+};
+
+const uint16_t CONFIG_VERSION = 1;
+
+/**
+ * @brief Load and save the Config in the ESP32 NVS flash.
+ *
+ * The config is stored as a single versioned and checksummed blob so that it
+ * can be loaded with one read at boot. Saving is deferred until the config has
+ * stopped changing for a while and is skipped when nothing changed, to keep
+ * flash writes off the hot path and limit flash wear.
+ */
+class ConfigStore {
+public:
+  ConfigStore();
+
+  ConfigStore(const ConfigStore &) = delete;
+  ConfigStore &operator=(const ConfigStore &) = delete;
+
+  /**
+   * @brief Load the config from flash.
+   *
+   * Older versions are migrated to the current one. Falls back to the
+   * defaults when there is no stored config or it is corrupt, of an unknown
+   * version or from a newer version. A stored config that isn't in the current
+   * format is rewritten by a later update(). Blobs from newer firmware, a newer
+   * version or with appended fields, are only replaced once the config is
+   * set(), so that temporarily running older firmware doesn't lose them.
+   *
+   * @return The loaded config.
+   */
+  const Config &load();
+
+  /**
+   * @brief The current config.
+   */
+  const Config &config() const { return _config; }
+
+  /**
+   * @brief Change the config and schedule it to be saved.
+   *
+   * @param config The new config.
+   * @param now The current time in ms, e.g. millis().
+   */
+  void set(const Config &config, uint32_t now);
+
+  /**
+   * @brief Save the config if it has settled since the last change.
+   *
+   * Must be called regularly (e.g., in loop()). Only touches flash when a
+   * change has been pending for long enough. A flash write blocks for
+   * milliseconds, so call this once the mouse has been idle for a while.
+   *
+   * @param now The current time in ms, e.g. millis().
+   * @return true if the config was written to flash.
+   */
+  bool update(uint32_t now);
+
+private:
+  Preferences _preferences;
+  Config _config;
+  // The config as it is in flash
+  Config _stored;
+  // The stored blob needs to be rewritten even if the config matches _stored
+  bool _rewrite;
+  bool _pending;
+  uint32_t _changedAt;
+
+  // public for ease of testing
+public:
+  static uint32_t checksum(uint16_t version, const uint8_t *data,
+                           uint16_t size);
+};
+#endif // CONFIG_STORE_HPP
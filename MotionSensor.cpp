@@ -53,17 +53,24 @@ const int MAX_CLOCK_SPEED = 1'000'000;
  * sensor initialization sequence.
  *
  * @param cs Chip-select pin connected to the sensor.
- * @param dpi Sensor DPI value (logical configuration; may be used elsewhere).
+ * @param resolution Sensor resolution in 250 DPI steps, see
+ *        dpiToRegisterValue(). Clamped to the supported 1-14.
  * @param sck Serial clock pin (SCLK).
  * @param cipo Controller-In-Peripheral-Out pin (CIPO).
  * @param copi Controller-Out-Peripheral-In pin (COPI).
  */
-MotionSensor::MotionSensor(int8_t cs, uint16_t dpi, int8_t sck, int8_t cipo,
-                           int8_t copi) {
+MotionSensor::MotionSensor(int8_t cs, uint8_t resolution, int8_t sck,
+                           int8_t cipo, int8_t copi) {
   SPI.begin(sck, cipo, copi);
   _settings = SPISettings(MAX_CLOCK_SPEED, SPI_MSBFIRST, SPI_MODE3);
   _cs = cs;
-  _resolution = dpiToRegisterValue(dpi);
+  if (resolution < 1) {
+    resolution = 1;
+  }
+  if (resolution > MAX_DPI / DPI_RESOLUTION) {
+    resolution = MAX_DPI / DPI_RESOLUTION;
+  }
+  _resolution = resolution;
 
   pinMode(_cs, OUTPUT);
   digitalWrite(_cs, HIGH); // Deselect initially
@@ -30,13 +30,14 @@ public:
    * sensor initialization sequence.
    *
    * @param cs Chip-select pin connected to the sensor.
-   * @param dpi Sensor DPI value (logical configuration; may be used elsewhere).
+   * @param resolution Sensor resolution in 250 DPI steps, see
+   *        dpiToRegisterValue(). Clamped to the supported 1-14.
    * @param sck Serial clock pin (SCLK).
    * @param cipo Controller-In-Peripheral-Out pin (CIPO).
    * @param copi Controller-Out-Peripheral-In pin (COPI).
    */
-  MotionSensor(int8_t cs, uint16_t dpi, int8_t sck = -1, int8_t cipo = -1,
-               int8_t copi = -1);
+  MotionSensor(int8_t cs, uint8_t resolution, int8_t sck = -1,
+               int8_t cipo = -1, int8_t copi = -1);
 
   MotionSensor(const MotionSensor &) = delete;
   MotionSensor &operator=(const MotionSensor &) = delete;
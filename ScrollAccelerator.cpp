@@ -0,0 +1,117 @@
+#include "ScrollAccelerator.hpp"
+
+// Time without any steps after which the wheel is considered to be at rest, in
+// µs. Anything slower than this is well below any useful threshold speed.
+const uint32_t IDLE_TIMEOUT = 150'000;
+
+const uint32_t MICROS_PER_SECOND = 1'000'000;
+
+ScrollAccelerator::ScrollAccelerator(const GainTable &gains, uint8_t resolution)
+    : _gains(gains), _resolution(resolution), _history() {
+  reset();
+}
+
+int8_t ScrollAccelerator::wheel(int8_t steps, uint32_t now) {
+  return (int8_t)accelerate(steps, now, 1, INT8_MAX);
+}
+
+int16_t ScrollAccelerator::highResolutionWheel(int8_t steps, uint32_t now) {
+  return (int16_t)accelerate(steps, now, _resolution, INT16_MAX);
+}
+
+/**
+ * @brief Scale the steps by the gain for the current wheel speed.
+ *
+ * Records the steps in the history, looks up the gain for the resulting speed
+ * and returns the whole output counts, keeping the fractional part and
+ * anything beyond @p limit for the next call. With no steps only the whole
+ * counts carried over from previous calls are returned.
+ *
+ * @param steps The raw steps since the last call, or 0.
+ * @param now The time the steps were read, in µs.
+ * @param scale Output counts per step.
+ * @param limit The largest magnitude the caller can report.
+ * @return The accelerated output counts, in the direction of @p steps.
+ */
+int32_t ScrollAccelerator::accelerate(int8_t steps, uint32_t now,
+                                      uint8_t scale, int32_t limit) {
+  if (steps == 0) {
+    int32_t counts = _remainder / UNITY_GAIN;
+    if (counts > limit) {
+      counts = limit;
+    }
+    _remainder -= counts * UNITY_GAIN;
+    return _direction * counts;
+  }
+
+  int8_t direction = steps > 0 ? 1 : -1;
+  if (_historyCount != 0) {
+    const auto &last = _history[(_head + HISTORY_SIZE - 1) % HISTORY_SIZE];
+    if (direction != _direction || now - last.timestamp > IDLE_TIMEOUT) {
+      reset();
+    }
+  }
+  _direction = direction;
+
+  // int8_t can't represent +128 so go through int for the magnitude
+  uint8_t magnitude = (uint8_t)(steps > 0 ? steps : -(int)steps);
+  uint16_t stepGain = gain(stepsPerSecond(magnitude, now));
+
+  _history[_head] = {now, magnitude};
+  _head = (_head + 1) % HISTORY_SIZE;
+  if (_historyCount < HISTORY_SIZE) {
+    _historyCount++;
+  }
+
+  int32_t total = (int32_t)magnitude * stepGain * scale + _remainder;
+  int32_t counts = total / UNITY_GAIN;
+  if (counts > limit) {
+    counts = limit;
+  }
+  _remainder = total - counts * UNITY_GAIN;
+  return direction * counts;
+}
+
+void ScrollAccelerator::reset() {
+  _head = 0;
+  _historyCount = 0;
+  _direction = 0;
+  _remainder = 0;
+}
+
+/**
+ * @brief Compute the wheel speed including a new batch of steps.
+ *
+ * The speed is the steps taken since the oldest batch in the history divided
+ * by the time since that batch. With no history the wheel is considered to
+ * be starting from rest.
+ *
+ * @param steps The magnitude of the new batch of steps.
+ * @param now The time the new batch was read, in µs.
+ * @return The wheel speed in steps per second.
+ */
+uint32_t ScrollAccelerator::stepsPerSecond(uint8_t steps, uint32_t now) const {
+  if (_historyCount == 0) {
+    return 0;
+  }
+
+  size_t oldest = (_head + HISTORY_SIZE - _historyCount) % HISTORY_SIZE;
+  uint32_t totalSteps = steps;
+  for (size_t i = 1; i < _historyCount; i++) {
+    totalSteps += _history[(oldest + i) % HISTORY_SIZE].steps;
+  }
+
+  uint32_t elapsed = now - _history[oldest].timestamp;
+  if (elapsed == 0) {
+    elapsed = 1;
+  }
+  return (uint32_t)((uint64_t)totalSteps * MICROS_PER_SECOND / elapsed);
+}
+
+uint16_t ScrollAccelerator::gain(uint32_t speed) const {
+  size_t index = speed / SPEED_BUCKET;
+  if (index >= _gains.size()) {
+    index = _gains.size() - 1;
+  }
+  return _gains[index];
+}
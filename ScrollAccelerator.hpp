@@ -0,0 +1,150 @@
+#ifndef SCROLL_ACCELERATOR_HPP
+#define SCROLL_ACCELERATOR_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Gains are fixed point with 8 fractional bits, 256 is a gain of 1.0
+const uint16_t UNITY_GAIN = 256;
+
+// Each gain table entry covers this many steps per second of wheel speed
+const uint16_t SPEED_BUCKET = 4;
+const size_t GAIN_TABLE_SIZE = 64;
+
+using GainTable = std::array<uint16_t, GAIN_TABLE_SIZE>;
+
+/**
+ * @brief Shape of the scroll acceleration curve.
+ *
+ * The gain is exactly 1 at or below @p thresholdSpeed, ramps linearly up to
+ * @p maxGain at @p saturationSpeed and stays at @p maxGain past that.
+ */
+struct AccelerationCurve {
+  // Steps per second at or below which scrolling is not accelerated
+  uint16_t thresholdSpeed;
+  // Steps per second at which the gain reaches maxGain
+  uint16_t saturationSpeed;
+  // Gain at and above saturationSpeed, see UNITY_GAIN
+  uint16_t maxGain;
+};
+
+/**
+ * @brief Check that an acceleration curve can be tabulated.
+ *
+ * The curve must not decelerate and must ramp up to its saturation speed.
+ * Check any curve passed to makeGainTable() with a static_assert.
+ */
+constexpr bool isValidCurve(const AccelerationCurve &curve) {
+  return curve.maxGain >= UNITY_GAIN &&
+         curve.thresholdSpeed <= curve.saturationSpeed;
+}
+
+/**
+ * @brief Tabulate an acceleration curve into per speed bucket gains.
+ *
+ * Intended to be evaluated at compile time so that the scroll path is a single
+ * table lookup.
+ *
+ * @param curve The acceleration curve to tabulate.
+ * @return The gain for each SPEED_BUCKET wide speed range.
+ */
+constexpr GainTable makeGainTable(const AccelerationCurve &curve) {
+  GainTable table{};
+  for (size_t i = 0; i < table.size(); i++) {
+    uint32_t speed = i * SPEED_BUCKET;
+    if (speed <= curve.thresholdSpeed) {
+      table[i] = UNITY_GAIN;
+    } else if (speed >= curve.saturationSpeed) {
+      table[i] = curve.maxGain;
+    } else {
+      uint32_t ramp = (uint32_t)(curve.maxGain - UNITY_GAIN) *
+                      (speed - curve.thresholdSpeed) /
+                      (curve.saturationSpeed - curve.thresholdSpeed);
+      table[i] = (uint16_t)(UNITY_GAIN + ramp);
+    }
+  }
+  return table;
+}
+
+// Slow scrolling (~8 detents a second) stays 1:1, fast spins go up to 8x
+constexpr AccelerationCurve DEFAULT_SCROLL_CURVE = {8, 200, 8 * UNITY_GAIN};
+static_assert(isValidCurve(DEFAULT_SCROLL_CURVE),
+              "invalid default scroll acceleration curve");
+constexpr GainTable DEFAULT_SCROLL_GAINS = makeGainTable(DEFAULT_SCROLL_CURVE);
+
+/**
+ * @brief Accelerate scroll wheel steps based on how fast the wheel is spun.
+ *
+ * Each batch of encoder steps is timestamped, the wheel speed is computed over
+ * the last few batches and the steps are scaled by the gain for that speed.
+ * Fractional steps are carried over to the next batch so that nothing is lost
+ * while spinning. An isolated step, or a slow scroll, always produces exactly
+ * one step of output per step of input.
+ */
+class ScrollAccelerator {
+public:
+  /**
+   * @brief Construct a ScrollAccelerator.
+   *
+   * @param gains The tabulated acceleration curve, see makeGainTable().
+   * @param resolution Output counts per wheel step of highResolutionWheel().
+   *        wheel() always reports one count per step.
+   */
+  ScrollAccelerator(const GainTable &gains = DEFAULT_SCROLL_GAINS,
+                    uint8_t resolution = 1);
+
+  /**
+   * @brief Accelerate scroll steps for a standard int8 wheel report.
+   *
+   * Reports one count per step regardless of the resolution. Output beyond
+   * the int8 range is carried over to the following calls. Call with 0 steps
+   * when the wheel hasn't moved to drain it. Don't mix with
+   * highResolutionWheel() on the same instance, the carry is in output counts.
+   *
+   * @param steps The raw steps since the last call, e.g. ScrollWheel::delta(),
+   *        or 0 if there were none.
+   * @param now The time the steps were read, in µs, e.g. micros().
+   * @return The accelerated wheel value in output counts.
+   */
+  int8_t wheel(int8_t steps, uint32_t now);
+
+  /**
+   * @brief Accelerate scroll steps for a high-resolution wheel report.
+   *
+   * Output beyond the int16 range is carried over like wheel().
+   *
+   * @param steps The raw steps since the last call, e.g. ScrollWheel::delta(),
+   *        or 0 if there were none.
+   * @param now The time the steps were read, in µs, e.g. micros().
+   * @return The accelerated wheel value in output counts, 1/resolution steps.
+   */
+  int16_t highResolutionWheel(int8_t steps, uint32_t now);
+
+private:
+  struct StepBatch {
+    uint32_t timestamp;
+    uint8_t steps;
+  };
+  // Number of previous batches the speed is computed over
+  static const size_t HISTORY_SIZE = 4;
+
+  GainTable _gains;
+  uint8_t _resolution;
+  std::array<StepBatch, HISTORY_SIZE> _history;
+  // Index the next batch will be stored at
+  size_t _head;
+  size_t _historyCount;
+  int8_t _direction;
+  // Fractional output counts, with the same fixed point as the gains
+  int32_t _remainder;
+
+  int32_t accelerate(int8_t steps, uint32_t now, uint8_t scale,
+                     int32_t limit);
+  void reset();
+
+  // public for ease of testing
+public:
+  uint32_t stepsPerSecond(uint8_t steps, uint32_t now) const;
+  uint16_t gain(uint32_t speed) const;
+};
+#endif // SCROLL_ACCELERATOR_HPP
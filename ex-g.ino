@@ -1,5 +1,7 @@
 #include "Button.hpp"
+#include "ConfigStore.hpp"
 #include "MotionSensor.hpp"
+#include "ScrollAccelerator.hpp"
 #include "ScrollWheel.hpp"
 #include <USB.h>
 #include <USBHIDMouse.h>
@@ -25,8 +27,15 @@ enum MouseButtonIndex : uint8_t {
 // This is achieved by holding down left and right click while plugging in the
 // device.
 bool serialUploadMode = false;
+ConfigStore configStore;
+// Time of the last report and how long after it the mouse is idle, in ms. Slow
+// trackball movement can leave many loop iterations between reports, so a
+// single quiet iteration isn't idle.
+unsigned long lastActivity = 0;
+const unsigned long IDLE_TIME = 500;
 std::optional<MotionSensor> sensor;
 std::optional<ScrollWheel> scrollWheel;
+ScrollAccelerator scrollAccelerator;
 MouseButton mouseButtons[] = {
     {D2, MOUSE_LEFT, {}},
     {D3, MOUSE_RIGHT, {}},
@@ -63,13 +72,17 @@ void setup() {
     return;
   }
 
+  // Load first so the sensor and buttons are initialized with the stored
+  // settings
+  const auto &config = configStore.load();
+
   Mouse.begin();
   USB.begin();
   // D8, D9, D10 are SPI pins
-  sensor.emplace(D7, 1500);
+  sensor.emplace(D7, config.resolution);
   scrollWheel.emplace(D0, D1);
   for (auto &mb : mouseButtons) {
-    mb.button.emplace(mb.pin);
+    mb.button.emplace(mb.pin, config.debounceInterval);
   }
 }
 
@@ -84,15 +97,19 @@ void loop() {
     return;
   }
   auto motion = sensor->motion();
-  auto scroll = scrollWheel->delta();
-  if (motion || scroll) {
+  // Called even without steps to drain any carried over scroll
+  int8_t scroll =
+      scrollAccelerator.wheel(scrollWheel->delta().value_or(0), micros());
+  bool active = motion || scroll != 0;
+  if (active) {
     auto m = motion.value_or(Motion{0, 0});
-    Mouse.move(m.delta_x, m.delta_y, scroll.value_or(0));
+    Mouse.move(m.delta_x, m.delta_y, scroll);
   }
 
   for (auto &mb : mouseButtons) {
     auto state = mb.button->stateChange();
     if (state) {
+      active = true;
       if (*state == ButtonState::PRESSED) {
         Mouse.press(mb.mouseButton);
       } else {
@@ -100,4 +117,14 @@ void loop() {
       }
     }
   }
+
+  // Writing flash stalls the CPU for milliseconds, which would show up as a
+  // hitch in the cursor. Only save once the mouse has been idle for a while so
+  // any stall happens between gestures.
+  unsigned long now = millis();
+  if (active) {
+    lastActivity = now;
+  } else if (now - lastActivity >= IDLE_TIME) {
+    configStore.update(now);
+  }
 }
@@ -0,0 +1,3 @@
+#include "Preferences.h"
+
+NvsMock Nvs;
@@ -0,0 +1,101 @@
+#ifndef PREFERENCES_H_MOCK
+#define PREFERENCES_H_MOCK
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// In memory stand in for the NVS flash partition
+class NvsMock {
+public:
+  using Blob = std::vector<uint8_t>;
+  using Namespace = std::map<std::string, Blob>;
+
+  bool hasNamespace(const std::string &name) const {
+    return _namespaces.count(name) != 0;
+  }
+  Namespace &getNamespace(const std::string &name) {
+    return _namespaces[name];
+  }
+  // Direct access to a stored blob, e.g. to corrupt it
+  Blob &blob(const std::string &name, const std::string &key) {
+    return _namespaces[name][key];
+  }
+
+  void countRead() { _reads++; }
+  void countWrite() { _writes++; }
+  size_t getReads() const { return _reads; }
+  size_t getWrites() const { return _writes; }
+
+  void clearCounts() {
+    _reads = 0;
+    _writes = 0;
+  }
+  void clear() {
+    _namespaces.clear();
+    clearCounts();
+  }
+
+private:
+  std::map<std::string, Namespace> _namespaces;
+  size_t _reads = 0;
+  size_t _writes = 0;
+};
+
+extern NvsMock Nvs;
+
+class Preferences {
+public:
+  bool begin(const char *name, bool readOnly = false) {
+    // Like NVS, a read only open fails if the namespace was never written
+    if (readOnly && !Nvs.hasNamespace(name)) {
+      return false;
+    }
+    _namespace = &Nvs.getNamespace(name);
+    _readOnly = readOnly;
+    return true;
+  }
+  void end() { _namespace = nullptr; }
+
+  size_t putBytes(const char *key, const void *value, size_t len) {
+    if (_namespace == nullptr || _readOnly) {
+      return 0;
+    }
+    Nvs.countWrite();
+    auto bytes = static_cast<const uint8_t *>(value);
+    (*_namespace)[key] = NvsMock::Blob(bytes, bytes + len);
+    return len;
+  }
+
+  size_t getBytesLength(const char *key) {
+    if (_namespace == nullptr) {
+      return 0;
+    }
+    Nvs.countRead();
+    auto found = _namespace->find(key);
+    return found == _namespace->end() ? 0 : found->second.size();
+  }
+
+  size_t getBytes(const char *key, void *buf, size_t maxLen) {
+    if (_namespace == nullptr) {
+      return 0;
+    }
+    Nvs.countRead();
+    auto found = _namespace->find(key);
+    if (found == _namespace->end() || found->second.size() > maxLen) {
+      return 0;
+    }
+    auto bytes = static_cast<uint8_t *>(buf);
+    std::copy(found->second.begin(), found->second.end(), bytes);
+    return found->second.size();
+  }
+
+private:
+  NvsMock::Namespace *_namespace = nullptr;
+  bool _readOnly = false;
+};
+
+#endif // PREFERENCES_H_MOCK
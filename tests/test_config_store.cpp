@@ -0,0 +1,303 @@
+#include "ConfigStore.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <cstring>
+#include <vector>
+
+// Header layout, {version, size, checksum}
+const size_t HEADER_SIZE = 8;
+const size_t BLOB_SIZE = HEADER_SIZE + sizeof(Config);
+
+NvsMock::Blob &storedBlob() { return Nvs.blob("ex-g", "config"); }
+
+// Build a stored blob by hand for the given version and config bytes
+NvsMock::Blob makeBlob(uint16_t version, const uint8_t *data, uint16_t size) {
+  uint32_t checksum = ConfigStore::checksum(version, data, size);
+  NvsMock::Blob blob(HEADER_SIZE + size);
+  std::memcpy(&blob[0], &version, sizeof(version));
+  std::memcpy(&blob[2], &size, sizeof(size));
+  std::memcpy(&blob[4], &checksum, sizeof(checksum));
+  std::memcpy(&blob[HEADER_SIZE], data, size);
+  return blob;
+}
+
+void storeConfig(const Config &config) {
+  storedBlob() =
+      makeBlob(CONFIG_VERSION, (const uint8_t *)&config, sizeof(config));
+}
+
+TEST_CASE("load uses a single read and no writes", "[load-budget]") {
+  Nvs.clear();
+
+  SECTION("nothing stored") {
+    ConfigStore store;
+
+    REQUIRE(store.load() == Config{});
+    // The namespace doesn't exist so not even a read is needed
+    REQUIRE(Nvs.getReads() == 0);
+    REQUIRE(Nvs.getWrites() == 0);
+
+    SECTION("and the defaults are never written") {
+      REQUIRE_FALSE(store.update(100'000));
+      REQUIRE(Nvs.getWrites() == 0);
+    }
+  }
+
+  SECTION("config stored") {
+    storeConfig({3, 5});
+    Nvs.clearCounts();
+    ConfigStore store;
+
+    REQUIRE(store.load() == Config{3, 5});
+    REQUIRE(Nvs.getReads() == 1);
+    REQUIRE(Nvs.getWrites() == 0);
+  }
+
+  SECTION("config too large to read stored") {
+    std::vector<uint8_t> data(200, 0);
+    storedBlob() = makeBlob(CONFIG_VERSION, data.data(), data.size());
+    Nvs.clearCounts();
+    ConfigStore store;
+
+    REQUIRE(store.load() == Config{});
+    // The failed read and the length check
+    REQUIRE(Nvs.getReads() == 2);
+    REQUIRE(Nvs.getWrites() == 0);
+  }
+
+  SECTION("corrupt config stored") {
+    storeConfig({3, 5});
+    storedBlob()[HEADER_SIZE] ^= 0x01;
+    Nvs.clearCounts();
+    ConfigStore store;
+
+    REQUIRE(store.load() == Config{});
+    REQUIRE(Nvs.getReads() == 1);
+    REQUIRE(Nvs.getWrites() == 0);
+  }
+}
+
+TEST_CASE("stored config round trips", "[load]") {
+  Nvs.clear();
+  auto [resolution, debounce] = GENERATE(table<uint8_t, uint8_t>({
+      {1, 1},
+      {6, 2},
+      {14, 10},
+  }));
+  Config config{resolution, debounce};
+
+  storeConfig(config);
+  ConfigStore store;
+
+  REQUIRE(store.load() == config);
+  REQUIRE(store.config() == config);
+  REQUIRE(storedBlob().size() == BLOB_SIZE);
+}
+
+TEST_CASE("corrupt configs load the defaults", "[corruption]") {
+  Nvs.clear();
+  storeConfig({3, 5});
+  ConfigStore store;
+
+  SECTION("flipped bit in any byte") {
+    auto byte = GENERATE(range((size_t)0, BLOB_SIZE));
+    CAPTURE(byte);
+    storedBlob()[byte] ^= 0x10;
+
+    REQUIRE(store.load() == Config{});
+  }
+
+  SECTION("truncated") {
+    auto size = GENERATE(range((size_t)1, BLOB_SIZE));
+    CAPTURE(size);
+    storedBlob().resize(size);
+
+    REQUIRE(store.load() == Config{});
+  }
+
+  SECTION("too large") {
+    storedBlob().push_back(0);
+
+    REQUIRE(store.load() == Config{});
+  }
+
+  SECTION("the defaults are rewritten once settled") {
+    storedBlob()[HEADER_SIZE] ^= 0x01;
+    store.load();
+    Nvs.clearCounts();
+
+    REQUIRE_FALSE(store.update(4'999));
+    REQUIRE(store.update(5'000));
+    REQUIRE(Nvs.getWrites() == 1);
+
+    ConfigStore reloaded;
+    REQUIRE(reloaded.load() == Config{});
+    REQUIRE(storedBlob().size() == BLOB_SIZE);
+  }
+}
+
+TEST_CASE("config version migration", "[migration]") {
+  Nvs.clear();
+  Config config{3, 5};
+  auto data = (const uint8_t *)&config;
+
+  SECTION("current config missing newer fields keeps their defaults") {
+    // Only the resolution field
+    storedBlob() = makeBlob(CONFIG_VERSION, data, sizeof(config.resolution));
+    ConfigStore store;
+
+    REQUIRE(store.load() == Config{3, Config{}.debounceInterval});
+
+    SECTION("and is rewritten in the current format once settled") {
+      Nvs.clearCounts();
+      REQUIRE(store.update(5'000));
+      REQUIRE(Nvs.getWrites() == 1);
+      REQUIRE(storedBlob().size() == BLOB_SIZE);
+
+      ConfigStore reloaded;
+      REQUIRE(reloaded.load() == Config{3, Config{}.debounceInterval});
+      Nvs.clearCounts();
+      REQUIRE_FALSE(reloaded.update(10'000));
+      REQUIRE(Nvs.getWrites() == 0);
+    }
+  }
+
+  SECTION("unknown versions load the defaults") {
+    storedBlob() = makeBlob(0, data, sizeof(config));
+    ConfigStore store;
+
+    REQUIRE(store.load() == Config{});
+  }
+
+  SECTION("newer versions load the defaults") {
+    storedBlob() = makeBlob(CONFIG_VERSION + 1, data, sizeof(config));
+    auto newer = storedBlob();
+    ConfigStore store;
+
+    REQUIRE(store.load() == Config{});
+
+    SECTION("and are kept until the config is set") {
+      Nvs.clearCounts();
+      REQUIRE_FALSE(store.update(5'000));
+      REQUIRE_FALSE(store.update(100'000));
+      REQUIRE(Nvs.getWrites() == 0);
+      REQUIRE(storedBlob() == newer);
+
+      store.set(Config{}, 100'000);
+      REQUIRE(store.update(105'000));
+      REQUIRE(Nvs.getWrites() == 1);
+      REQUIRE(storedBlob() == makeBlob(CONFIG_VERSION,
+                                       (const uint8_t *)&store.config(),
+                                       sizeof(Config)));
+    }
+  }
+
+  SECTION("checksum covers the version") {
+    auto blob = makeBlob(CONFIG_VERSION, data, sizeof(config));
+    uint16_t version = CONFIG_VERSION + 1;
+    std::memcpy(&blob[0], &version, sizeof(version));
+    storedBlob() = blob;
+    ConfigStore store;
+
+    REQUIRE(store.load() == Config{});
+  }
+}
+
+TEST_CASE("appended fields from newer firmware are kept", "[migration]") {
+  Nvs.clear();
+  // Larger than the current Config, and larger than the read buffer
+  auto extra = GENERATE((size_t)1, (size_t)40, (size_t)100);
+  CAPTURE(extra);
+  std::vector<uint8_t> data(sizeof(Config) + extra, 42);
+  data[0] = 3;
+  data[1] = 5;
+  storedBlob() = makeBlob(CONFIG_VERSION, data.data(), data.size());
+  auto newer = storedBlob();
+  ConfigStore store;
+
+  // Fields this firmware knows about load, unless the blob can't be read
+  auto expected = extra < 64 ? Config{3, 5} : Config{};
+  REQUIRE(store.load() == expected);
+
+  SECTION("and not rewritten by update") {
+    Nvs.clearCounts();
+    REQUIRE_FALSE(store.update(5'000));
+    REQUIRE_FALSE(store.update(100'000));
+    REQUIRE(Nvs.getWrites() == 0);
+    REQUIRE(storedBlob() == newer);
+  }
+
+  SECTION("until the config is set") {
+    store.set(store.config(), 100'000);
+    REQUIRE(store.update(105'000));
+    REQUIRE(storedBlob().size() == BLOB_SIZE);
+
+    ConfigStore reloaded;
+    REQUIRE(reloaded.load() == expected);
+  }
+}
+
+TEST_CASE("writes are deferred until the config settles", "[deferred-write]") {
+  Nvs.clear();
+  storeConfig({6, 2});
+  ConfigStore store;
+  store.load();
+  Nvs.clearCounts();
+
+  SECTION("nothing to write") {
+    REQUIRE_FALSE(store.update(0));
+    REQUIRE_FALSE(store.update(100'000));
+    REQUIRE(Nvs.getWrites() == 0);
+  }
+
+  SECTION("set doesn't write") {
+    store.set({3, 2}, 1'000);
+
+    REQUIRE(store.config() == Config{3, 2});
+    REQUIRE(Nvs.getWrites() == 0);
+  }
+
+  SECTION("write once settled") {
+    store.set({3, 2}, 1'000);
+
+    REQUIRE_FALSE(store.update(1'000));
+    REQUIRE_FALSE(store.update(5'999));
+    REQUIRE(Nvs.getWrites() == 0);
+    REQUIRE(store.update(6'000));
+    REQUIRE(Nvs.getWrites() == 1);
+    REQUIRE_FALSE(store.update(20'000));
+    REQUIRE(Nvs.getWrites() == 1);
+
+    ConfigStore reloaded;
+    REQUIRE(reloaded.load() == Config{3, 2});
+  }
+
+  SECTION("rapid changes are a single write") {
+    for (uint32_t i = 0; i < 10; i++) {
+      store.set({(uint8_t)(i + 1), 2}, i * 1'000);
+      store.update(i * 1'000);
+    }
+    REQUIRE(Nvs.getWrites() == 0);
+
+    REQUIRE(store.update(14'000));
+    REQUIRE(Nvs.getWrites() == 1);
+
+    ConfigStore reloaded;
+    REQUIRE(reloaded.load() == Config{10, 2});
+  }
+
+  SECTION("changing back to the stored config doesn't write") {
+    store.set({3, 2}, 1'000);
+    store.set({6, 2}, 2'000);
+
+    REQUIRE_FALSE(store.update(10'000));
+    REQUIRE(Nvs.getWrites() == 0);
+  }
+
+  SECTION("millis wrap around") {
+    store.set({3, 2}, UINT32_MAX - 1'000);
+
+    REQUIRE_FALSE(store.update(UINT32_MAX));
+    REQUIRE(store.update(4'000));
+  }
+}
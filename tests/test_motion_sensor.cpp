@@ -9,7 +9,7 @@ TEST_CASE("MotionSensor initializes PMW3320DB-TYDU", "[PMW-Init]") {
   }));
   SPI.clearMessages();
 
-  auto sensor = MotionSensor(3, dpi);
+  auto sensor = MotionSensor(3, MotionSensor::dpiToRegisterValue(dpi));
 
   const auto &messages = SPI.getMessages();
 
@@ -38,9 +38,24 @@ TEST_CASE("MotionSensor initializes PMW3320DB-TYDU", "[PMW-Init]") {
   REQUIRE(messages[19] == SPIMessage{0x04, 0x00}); // read(DELTA_Y)
 }
 
+TEST_CASE("MotionSensor clamps the resolution", "[PMW-Init]") {
+  auto [resolution, expected_resolution] = GENERATE(table<uint8_t, uint8_t>({
+      {0, 0x81},
+      {15, 0x8E},
+      {0x7F, 0x8E},
+  }));
+  SPI.clearMessages();
+
+  auto sensor = MotionSensor(3, resolution);
+
+  const auto &messages = SPI.getMessages();
+  REQUIRE(messages[13] ==
+          SPIMessage{0x8D, expected_resolution}); // write(RESOLUTION, value)
+}
+
 TEST_CASE("motion reads registers and returns value", "[motion]") {
   const int8_t cs_pin = 5;
-  auto sensor = MotionSensor(cs_pin, 750);
+  auto sensor = MotionSensor(cs_pin, MotionSensor::dpiToRegisterValue(750));
 
   // Clear events from init
   Arduino.clearEvents();
@@ -90,7 +105,7 @@ TEST_CASE("motion reads registers and returns value", "[motion]") {
 
 TEST_CASE("read and write toggle CS appropriately", "[SPI-CS]") {
   const int8_t cs_pin = 3;
-  auto sensor = MotionSensor(cs_pin, 1000);
+  auto sensor = MotionSensor(cs_pin, MotionSensor::dpiToRegisterValue(1000));
 
   // Clear events from init
   Arduino.clearEvents();
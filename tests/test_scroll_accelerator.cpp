@@ -0,0 +1,245 @@
+#include "ScrollAccelerator.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <vector>
+
+struct Detents {
+  uint32_t interval;
+  int8_t steps;
+};
+
+// Feed the detents to the accelerator, returning the total output
+int32_t spin(ScrollAccelerator &accelerator, uint32_t start,
+             const std::vector<Detents> &detents) {
+  int32_t total = 0;
+  uint32_t now = start;
+  for (const auto &d : detents) {
+    now += d.interval;
+    total += accelerator.wheel(d.steps, now);
+  }
+  return total;
+}
+
+TEST_CASE("makeGainTable tabulates the acceleration curve", "[gain-table]") {
+  constexpr auto table = makeGainTable({8, 40, 4 * UNITY_GAIN});
+
+  // Evaluated at compile time
+  static_assert(table[0] == UNITY_GAIN);
+
+  SECTION("unity gain at or below the threshold") {
+    REQUIRE(table[0] == UNITY_GAIN);
+    REQUIRE(table[1] == UNITY_GAIN);
+    REQUIRE(table[2] == UNITY_GAIN);
+  }
+
+  SECTION("linear ramp between threshold and saturation") {
+    // 12 steps/s is 1/8 of the way from 8 to 40
+    REQUIRE(table[3] == UNITY_GAIN + 3 * UNITY_GAIN / 8);
+    // 24 steps/s is half way
+    REQUIRE(table[6] == UNITY_GAIN + 3 * UNITY_GAIN / 2);
+  }
+
+  SECTION("max gain at and past saturation") {
+    auto index = GENERATE(10, 11, 32, 63);
+    CAPTURE(index);
+    REQUIRE(table[index] == 4 * UNITY_GAIN);
+  }
+}
+
+TEST_CASE("isValidCurve rejects curves that can't be tabulated",
+          "[gain-table]") {
+  static_assert(isValidCurve(DEFAULT_SCROLL_CURVE));
+  static_assert(isValidCurve({8, 8, UNITY_GAIN}));
+  // Decelerating
+  static_assert(!isValidCurve({8, 200, UNITY_GAIN - 1}));
+  // Threshold past saturation
+  static_assert(!isValidCurve({200, 8, 2 * UNITY_GAIN}));
+  SUCCEED();
+}
+
+TEST_CASE("stepsPerSecond computes speed from timestamped steps", "[speed]") {
+  ScrollAccelerator accelerator;
+
+  SECTION("no history is at rest") {
+    REQUIRE(accelerator.stepsPerSecond(1, 1'000'000) == 0);
+  }
+
+  SECTION("speed since the previous batch") {
+    accelerator.wheel(1, 1'000'000);
+    REQUIRE(accelerator.stepsPerSecond(1, 1'010'000) == 100);
+    REQUIRE(accelerator.stepsPerSecond(2, 1'010'000) == 200);
+  }
+
+  SECTION("speed across the history") {
+    accelerator.wheel(1, 1'000'000);
+    accelerator.wheel(1, 1'010'000);
+    accelerator.wheel(1, 1'030'000);
+    // 3 steps over 40 ms
+    REQUIRE(accelerator.stepsPerSecond(1, 1'040'000) == 75);
+  }
+
+  SECTION("timestamps wrap around") {
+    accelerator.wheel(1, UINT32_MAX - 4'999);
+    REQUIRE(accelerator.stepsPerSecond(1, 5'000) == 100);
+  }
+}
+
+TEST_CASE("single detents are not accelerated", "[wheel]") {
+  ScrollAccelerator accelerator;
+  auto steps = GENERATE(1, -1, 2, -3);
+  CAPTURE(steps);
+
+  SECTION("isolated detent") {
+    REQUIRE(accelerator.wheel(steps, 1'000'000) == steps);
+  }
+
+  SECTION("detents separated by the idle timeout") {
+    REQUIRE(accelerator.wheel(steps, 1'000'000) == steps);
+    REQUIRE(accelerator.wheel(steps, 1'200'000) == steps);
+    REQUIRE(accelerator.wheel(steps, 1'400'000) == steps);
+  }
+
+  SECTION("slow scrolling") {
+    // 5 detents per second
+    std::vector<Detents> detents(20, Detents{200'000, (int8_t)steps});
+    REQUIRE(spin(accelerator, 0, detents) == 20 * steps);
+  }
+}
+
+TEST_CASE("fast spins scroll further", "[wheel]") {
+  ScrollAccelerator accelerator;
+  auto direction = GENERATE(1, -1);
+  CAPTURE(direction);
+
+  SECTION("saturated spin reaches max gain") {
+    // 250 detents per second
+    std::vector<Detents> detents(40, Detents{4'000, (int8_t)direction});
+    int32_t total = spin(accelerator, 0, detents);
+    // The first detent starts from rest and the speed builds over the history
+    REQUIRE(direction * total > 30 * 8);
+    REQUIRE(direction * total <= 40 * 8);
+  }
+
+  SECTION("faster spins scroll proportionally further") {
+    std::vector<Detents> slow(20, Detents{40'000, (int8_t)direction});
+    std::vector<Detents> medium(20, Detents{20'000, (int8_t)direction});
+    std::vector<Detents> fast(20, Detents{10'000, (int8_t)direction});
+
+    int32_t slowTotal = direction * spin(accelerator, 0, slow);
+    int32_t mediumTotal = direction * spin(accelerator, 10'000'000, medium);
+    int32_t fastTotal = direction * spin(accelerator, 20'000'000, fast);
+
+    REQUIRE(slowTotal > 20);
+    REQUIRE(mediumTotal > slowTotal);
+    REQUIRE(fastTotal > mediumTotal);
+  }
+
+  SECTION("multiple steps per read are the same speed as single steps") {
+    ScrollAccelerator pairs;
+    spin(accelerator, 0, std::vector<Detents>(8, {5'000, (int8_t)direction}));
+    spin(pairs, 0, std::vector<Detents>(4, {10'000, (int8_t)(2 * direction)}));
+
+    REQUIRE(accelerator.stepsPerSecond(1, 45'000) == 200);
+    REQUIRE(pairs.stepsPerSecond(2, 50'000) == 200);
+  }
+}
+
+TEST_CASE("fractional output is carried over", "[wheel]") {
+  // 1.5x once moving at or above 4 steps/s
+  constexpr auto table = makeGainTable({0, 4, UNITY_GAIN + UNITY_GAIN / 2});
+  ScrollAccelerator accelerator(table);
+
+  REQUIRE(accelerator.wheel(1, 1'000'000) == 1);
+  REQUIRE(accelerator.wheel(1, 1'010'000) == 1);
+  REQUIRE(accelerator.wheel(1, 1'020'000) == 2);
+  REQUIRE(accelerator.wheel(1, 1'030'000) == 1);
+  REQUIRE(accelerator.wheel(1, 1'040'000) == 2);
+
+  SECTION("direction change discards the fraction") {
+    REQUIRE(accelerator.wheel(1, 1'050'000) == 1);
+    REQUIRE(accelerator.wheel(-1, 1'060'000) == -1);
+    REQUIRE(accelerator.wheel(1, 1'070'000) == 1);
+  }
+
+  SECTION("idle discards the fraction") {
+    REQUIRE(accelerator.wheel(1, 1'050'000) == 1);
+    REQUIRE(accelerator.wheel(1, 2'000'000) == 1);
+  }
+}
+
+TEST_CASE("wheel output beyond int8 is carried over", "[wheel]") {
+  constexpr auto table = makeGainTable({0, 4, 8 * UNITY_GAIN});
+  ScrollAccelerator accelerator(table);
+
+  REQUIRE(accelerator.wheel(100, 1'000'000) == 100);
+  // 800 counts, only 127 fit
+  REQUIRE(accelerator.wheel(100, 1'010'000) == INT8_MAX);
+
+  SECTION("more steps add to the carry") {
+    REQUIRE(accelerator.wheel(1, 1'020'000) == INT8_MAX);
+  }
+
+  SECTION("no steps drains the carry") {
+    int32_t drained = 0;
+    for (uint32_t now = 1'010'001; now < 1'010'010; now++) {
+      drained += accelerator.wheel(0, now);
+    }
+    REQUIRE(drained == 800 - INT8_MAX);
+
+    SECTION("and nothing is left after a pause") {
+      REQUIRE(accelerator.wheel(0, 2'000'000) == 0);
+      REQUIRE(accelerator.wheel(1, 2'000'000) == 1);
+    }
+  }
+
+  SECTION("drains in the direction of the steps") {
+    REQUIRE(accelerator.wheel(-100, 3'000'000) == -100);
+    REQUIRE(accelerator.wheel(-100, 3'010'000) == INT8_MIN + 1);
+    REQUIRE(accelerator.wheel(0, 3'010'001) == INT8_MIN + 1);
+  }
+}
+
+TEST_CASE("no steps without a carry is no output", "[wheel]") {
+  ScrollAccelerator accelerator;
+
+  REQUIRE(accelerator.wheel(0, 1'000'000) == 0);
+  REQUIRE(accelerator.wheel(1, 1'000'000) == 1);
+  REQUIRE(accelerator.wheel(0, 1'000'001) == 0);
+}
+
+TEST_CASE("temporary gain tables are copied", "[gain-table]") {
+  ScrollAccelerator accelerator(makeGainTable({0, 4, 2 * UNITY_GAIN}));
+
+  REQUIRE(accelerator.gain(0) == UNITY_GAIN);
+  REQUIRE(accelerator.gain(100) == 2 * UNITY_GAIN);
+}
+
+TEST_CASE("highResolutionWheel scales by the resolution", "[high-resolution]") {
+  auto resolution = GENERATE(1, 8, 120);
+  CAPTURE(resolution);
+  ScrollAccelerator accelerator(DEFAULT_SCROLL_GAINS, resolution);
+
+  SECTION("wheel ignores the resolution") {
+    REQUIRE(accelerator.wheel(1, 1'000'000) == 1);
+    REQUIRE(accelerator.wheel(-1, 2'000'000) == -1);
+  }
+
+  SECTION("single detents are exact") {
+    REQUIRE(accelerator.highResolutionWheel(1, 1'000'000) == resolution);
+    REQUIRE(accelerator.highResolutionWheel(-1, 2'000'000) == -resolution);
+  }
+
+  SECTION("fast spins match the standard wheel") {
+    ScrollAccelerator standard;
+    uint32_t now = 0;
+    int32_t highResolutionTotal = 0;
+    int32_t standardTotal = 0;
+    for (int i = 0; i < 40; i++) {
+      now += 6'000;
+      highResolutionTotal += accelerator.highResolutionWheel(1, now);
+      standardTotal += standard.wheel(1, now);
+    }
+    REQUIRE(standardTotal > 40);
+    REQUIRE(highResolutionTotal / resolution == standardTotal);
+  }
+}